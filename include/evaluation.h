@@ -0,0 +1,50 @@
+#pragma once
+
+#include "game_state.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct PawnEntry {
+  uint64_t key = 0;
+  bool valid = false;
+  // 兵型得分 (通过兵、叠兵、孤兵、落后兵), 白方视角.
+  int score = 0;
+  // 王位于某一列时前方兵盾的得分, 按 [颜色][王所在列] 存放.
+  std::array<std::array<int, 8>, 2> shelter{};
+};
+
+// 固定大小、直接映射的兵型缓存. 不是线程安全的, 每个线程各持有一个.
+class PawnHashTable {
+ public:
+  explicit PawnHashTable(size_t entry_count = 16384);
+
+  PawnEntry& probe(uint64_t key, bool& found);
+
+  uint64_t probes() const { return probes_; }
+  uint64_t hits() const { return hits_; }
+  double hit_rate() const {
+    return probes_ == 0 ? 0.0 : static_cast<double>(hits_) / probes_;
+  }
+
+ private:
+  std::vector<PawnEntry> entries_;
+  uint64_t mask_;
+  uint64_t probes_ = 0;
+  uint64_t hits_ = 0;
+};
+
+class Evaluator {
+ public:
+  // 白方视角的分值 (单位: 兵 = 100).
+  int evaluate(const GameState& state);
+
+  const PawnHashTable& pawn_table() const { return pawn_table_; }
+
+ private:
+  const PawnEntry& probe_pawns(const GameState& state);
+
+  PawnHashTable pawn_table_;
+};
+
+void evaluate_pawn_structure(const GameState& state, PawnEntry& entry);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "game_state.h"
+#include <optional>
+#include <string>
+
+std::optional<GameState> parse_fen(const std::string& fen);
@@ -2,12 +2,16 @@
 
 #include "game_state.h"
 #include "types.h"
+#include <array>
 #include <string>
 #include <vector>
 
+enum class MoveGenType { ALL, CAPTURES, QUIETS };
+
 class Game {
  public:
   Game();
+  explicit Game(const GameState& state);
 
   void make_move(const Move& move);
   GameState get_state() const;
@@ -17,22 +21,45 @@ class Game {
 
   std::vector<Move> get_all_legal_moves() const;
 
+  // 供搜索分阶段取走法: CAPTURES 包含吃子、吃过路兵和全部升变, QUIETS 为其余走法.
+  // 生成的是伪合法走法, 需要再用 is_move_legal 检查.
+  void generate_moves(const GameState& state,
+                      MoveGenType type,
+                      std::vector<Move>& moves) const;
+  bool is_pseudo_legal(const GameState& state, const Move& move) const;
+  bool is_move_legal(const GameState& state, const Move& move) const;
+
+  // 在给定局面上走一步 (含换边与回合计数), 不影响 Game 自身的局面.
+  void apply_move(GameState& state, const Move& move) const;
+  bool is_in_check(const GameState& state) const;
+
  private:
   GameState game_state_;
   mutable std::vector<Move> legal_moves_cache_;
   mutable bool cache_is_valid_ = false;
 
-
-  bool is_move_legal(const Move& move) const;
-
   std::vector<Move> generate_pseudo_legal_moves(
       const GameState& state) const;
+  template <Color Us>
+  void generate_moves(const GameState& state,
+                      MoveGenType type,
+                      std::vector<Move>& moves) const;
+  template <Color Us, MoveGenType Type>
+  void generate_pseudo_legal_moves(std::vector<Move>& moves,
+                                   const GameState& state) const;
+  template <Color Us, MoveGenType Type>
+  void generate_piece_moves(std::vector<Move>& moves,
+                            const GameState& state,
+                            const Position& from) const;
 
   bool is_king_in_check(Color color, const GameState& state) const;
 
   bool is_square_attacked(const Position& pos,
                             Color attacker_color,
                             const GameState& state) const;
+  template <Color Attacker>
+  bool is_square_attacked(const Position& pos,
+                          const GameState& state) const;
 
   void make_temporary_move(GameState& temp_state, const Move& move) const;
 
@@ -40,23 +67,27 @@ class Game {
                                 const Move& move,
                                 char piece_moved) const;
 
+  template <Color Us, MoveGenType Type>
   void generate_pawn_moves(std::vector<Move>& moves,
                            const GameState& state,
                            const Position& from) const;
+  template <Color Us, MoveGenType Type>
   void generate_knight_moves(std::vector<Move>& moves,
                              const GameState& state,
                              const Position& from) const;
+  template <Color Us, MoveGenType Type>
   void generate_king_moves(std::vector<Move>& moves,
                            const GameState& state,
                            const Position& from) const;
+  template <Color Us, MoveGenType Type, size_t N>
   void generate_sliding_moves(std::vector<Move>& moves,
                               const GameState& state,
                               const Position& from,
-                              const std::vector<Position>& directions) const;
+                              const std::array<Position, N>& directions) const;
 
+  template <Color Us, MoveGenType Type>
   void add_move(std::vector<Move>& moves,
                 const GameState& state,
                 const Position& from,
-                const Position& to,
-                bool is_capture) const;
+                const Position& to) const;
 };
\ No newline at end of file
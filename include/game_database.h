@@ -0,0 +1,103 @@
+#pragma once
+
+#include "game_state.h"
+#include "mapped_file.h"
+#include "types.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct PositionHit {
+  uint32_t game_id;
+  uint32_t ply;
+};
+
+struct PositionIndexSlot {
+  uint64_t key;
+  uint32_t first;
+  uint32_t count;
+};
+
+static_assert(sizeof(PositionHit) == 8, "PositionHit is part of index.bin");
+static_assert(sizeof(PositionIndexSlot) == 16,
+              "PositionIndexSlot is part of index.bin");
+
+struct PositionHits {
+  const PositionHit* data = nullptr;
+  size_t size = 0;
+
+  const PositionHit* begin() const { return data; }
+  const PositionHit* end() const { return data + size; }
+};
+
+uint16_t encode_move(const Move& move);
+Move decode_move(uint16_t code);
+
+// 将 PGN 对局经 Game::make_move 回放后写成两个文件:
+//   games.bin  每步 16 位编码的紧凑棋谱, 以及每盘的起始局面 FEN
+//              (标准开局为空串)
+//   index.bin  局面键 -> (对局编号, 手数) 的开放寻址哈希索引
+class GameDatabaseBuilder {
+ public:
+  explicit GameDatabaseBuilder(unsigned thread_count);
+
+  bool add_pgn_file(const std::string& path);
+  bool write(const std::string& directory);
+
+  size_t game_count() const { return move_offsets_.size() - 1; }
+  size_t rejected_count() const { return rejected_count_; }
+  size_t position_count() const { return entries_.size(); }
+
+ private:
+  struct IndexEntry {
+    uint64_t key;
+    uint32_t game_id;
+    uint32_t ply;
+  };
+
+  struct ReplayResult {
+    bool ok = false;
+    std::string start_fen;
+    std::vector<uint16_t> moves;
+    std::vector<uint64_t> keys;
+  };
+
+  void ingest_batch(const std::vector<std::string>& game_texts);
+  static ReplayResult replay_game(const std::string& game_text);
+
+  unsigned thread_count_;
+  std::vector<uint64_t> move_offsets_;
+  std::vector<uint16_t> moves_;
+  std::vector<uint64_t> fen_offsets_;
+  std::string fens_;
+  std::vector<IndexEntry> entries_;
+  size_t rejected_count_ = 0;
+};
+
+class GameDatabase {
+ public:
+  bool open(const std::string& directory);
+
+  PositionHits find(uint64_t key) const;
+
+  size_t game_count() const { return game_count_; }
+  // game_moves 从 game_start 给出的局面开始回放.
+  std::optional<GameState> game_start(uint32_t game_id) const;
+  std::vector<Move> game_moves(uint32_t game_id) const;
+  std::optional<Move> move_at(uint32_t game_id, uint32_t ply) const;
+
+ private:
+  MappedFile games_file_;
+  MappedFile index_file_;
+
+  uint64_t game_count_ = 0;
+  const uint64_t* move_offsets_ = nullptr;
+  const uint16_t* moves_ = nullptr;
+  const uint64_t* fen_offsets_ = nullptr;
+  const char* fens_ = nullptr;
+
+  uint64_t slot_mask_ = 0;
+  const PositionIndexSlot* slots_ = nullptr;
+  const PositionHit* postings_ = nullptr;
+};
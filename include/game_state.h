@@ -2,6 +2,7 @@
 
 #include "types.h"
 #include <array>
+#include <cstdint>
 #include <optional>
 
 struct CastlingRights {
@@ -20,6 +21,18 @@ struct GameState {
   
   int half_move_clock_ = 0;
   int fullmove_number_ = 1;
+
+  // 只由兵的位置决定的 Zobrist 键, 用于兵型评估缓存.
+  uint64_t pawn_key_ = 0;
+
+  // 各方棋子所在格 (row * 8 + col), 按 [颜色][下标] 存放; piece_index_
+  // 记录每格棋子在列表中的下标, 吃子时与末尾交换, O(1) 删除.
+  // 直接改写 board_ 后必须调用 rebuild_piece_lists.
+  std::array<std::array<int8_t, 16>, 2> piece_squares_{};
+  std::array<int, 2> piece_count_{};
+  std::array<int8_t, 64> piece_index_{};
+  std::array<Position, 2> king_square_{};
+
   GameState();
   
   char get_piece(const Position& pos) const {
@@ -29,7 +42,45 @@ struct GameState {
 
   void set_piece(const Position& pos, char piece) {
     if (pos.is_valid()) {
+      char old_piece = board_[pos.row][pos.col];
+      if (!is_empty_square(old_piece)) {
+        remove_from_list(old_piece, pos);
+      }
       board_[pos.row][pos.col] = piece;
+      if (!is_empty_square(piece)) {
+        add_to_list(piece, pos);
+      }
+    }
+  }
+
+  void rebuild_piece_lists();
+
+  static int color_index(Color color) {
+    return (color == Color::WHITE)? 0 : 1;
+  }
+
+ private:
+  void add_to_list(char piece, const Position& pos) {
+    int side = color_index(get_piece_color(piece));
+    int square = pos.row * 8 + pos.col;
+    piece_index_[square] = static_cast<int8_t>(piece_count_[side]);
+    piece_squares_[side][piece_count_[side]++] = static_cast<int8_t>(square);
+    if (char_to_piece_type(piece) == PieceType::KING) {
+      king_square_[side] = pos;
+    }
+  }
+
+  void remove_from_list(char piece, const Position& pos) {
+    int side = color_index(get_piece_color(piece));
+    int square = pos.row * 8 + pos.col;
+    int index = piece_index_[square];
+    int8_t last_square = piece_squares_[side][--piece_count_[side]];
+    piece_squares_[side][index] = last_square;
+    piece_index_[last_square] = static_cast<int8_t>(index);
+    piece_index_[square] = -1;
+    if (char_to_piece_type(piece) == PieceType::KING &&
+        king_square_[side] == pos) {
+      king_square_[side] = Position{};
     }
   }
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "game.h"
+#include "game_state.h"
+#include "types.h"
+#include <cstdint>
+#include <vector>
+
+struct MateResult {
+  bool found = false;
+  bool aborted = false;
+  int mate_in = 0;
+  // line 以将死结束时为 true; 取解线时达到节点上限则只含部分走法.
+  bool line_complete = false;
+  std::vector<Move> line;
+  uint64_t nodes = 0;
+  double seconds = 0;
+};
+
+// 基于深度优先证明数搜索 (df-pn) 的 N 步杀求解器.
+// 进攻方为根局面的行棋方; 置换表大小固定, 条目按 (局面, 剩余步数) 存放.
+class MateSolver {
+ public:
+  explicit MateSolver(size_t table_megabytes = 64);
+
+  // 依次尝试 1..max_moves 步杀, 返回步数最少的解. node_limit 为 0 表示不限.
+  MateResult solve(const GameState& root, int max_moves, uint64_t node_limit);
+
+ private:
+  struct TableEntry {
+    uint64_t key = 0;
+    uint64_t phi = 1;
+    uint64_t delta = 1;
+    uint64_t work = 0;
+    int proof_length = 0;
+  };
+
+  struct Child {
+    Move move;
+    GameState state;
+    uint64_t key;
+    bool gives_check;
+  };
+
+  static uint64_t node_key(const GameState& state, int remaining);
+
+  TableEntry lookup(uint64_t key) const;
+  void store(const TableEntry& entry);
+
+  bool has_legal_move(const GameState& state) const;
+  std::vector<Child> expand(const GameState& state, int remaining) const;
+  void mid(const GameState& state, uint64_t key, int remaining,
+           uint64_t threshold_phi, uint64_t threshold_delta);
+  bool prove(const GameState& state, int remaining);
+  bool extract_line(const GameState& root, int remaining,
+                    std::vector<Move>& line);
+
+  Game game_;
+  std::vector<TableEntry> table_;
+  uint64_t mask_;
+  uint64_t nodes_ = 0;
+  uint64_t node_limit_ = 0;
+  bool aborted_ = false;
+};
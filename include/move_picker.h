@@ -0,0 +1,53 @@
+#pragma once
+
+#include "game.h"
+#include "game_state.h"
+#include "types.h"
+#include <array>
+#include <optional>
+#include <vector>
+
+// 分阶段按需生成走法: 置换表走法 -> 按价值排序的吃子 -> 杀手走法 -> 安静走法.
+// 每个阶段只在被取到时才生成, 搜索在前几步截断时可以省去后面的生成与排序.
+// 返回的是伪合法走法, 调用方需用 Game::is_move_legal 检查.
+class MovePicker {
+ public:
+  MovePicker(const Game& game,
+             const GameState& state,
+             std::optional<Move> hash_move,
+             const std::array<Move, 2>& killers);
+
+  std::optional<Move> next();
+
+ private:
+  enum class Stage {
+    HASH_MOVE,
+    GENERATE_CAPTURES,
+    CAPTURES,
+    KILLERS,
+    GENERATE_QUIETS,
+    QUIETS,
+    DONE
+  };
+
+  struct ScoredMove {
+    Move move;
+    int score;
+  };
+
+  bool is_hash_move(const Move& move) const;
+  bool is_killer(const Move& move) const;
+  bool is_quiet(const Move& move) const;
+  int capture_score(const Move& move) const;
+
+  const Game& game_;
+  const GameState& state_;
+  std::optional<Move> hash_move_;
+  std::array<Move, 2> killers_;
+  Stage stage_ = Stage::HASH_MOVE;
+
+  std::vector<ScoredMove> captures_;
+  std::vector<Move> quiets_;
+  size_t current_ = 0;
+  size_t killer_index_ = 0;
+};
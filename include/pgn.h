@@ -0,0 +1,33 @@
+#pragma once
+
+#include "game_state.h"
+#include "types.h"
+#include <istream>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct PgnGame {
+  std::map<std::string, std::string> tags;
+  std::vector<std::string> san_moves;
+};
+
+class PgnReader {
+ public:
+  explicit PgnReader(std::istream& in) : in_(in) {}
+
+  // 读取下一盘棋的原始文本 (标签 + 棋谱), 没有更多对局时返回 false.
+  bool read_game_text(std::string& text);
+
+ private:
+  std::istream& in_;
+  std::string pending_line_;
+  bool has_pending_line_ = false;
+};
+
+PgnGame parse_pgn_game(const std::string& text);
+
+std::optional<Move> san_to_move(const std::string& san,
+                                const GameState& state,
+                                const std::vector<Move>& legal_moves);
@@ -31,6 +31,30 @@ struct Move {
   }
 };
 
+constexpr Color opposite_color(Color c) {
+  return (c == Color::WHITE)? Color::BLACK : Color::WHITE;
+}
+
+constexpr char colored_piece(Color c, char lower) {
+  return (c == Color::WHITE)? static_cast<char>(lower - 'a' + 'A') : lower;
+}
+
+inline std::string move_to_string(const Move& move) {
+  std::string s;
+  s += static_cast<char>('a' + move.from.col);
+  s += static_cast<char>('8' - move.from.row);
+  s += static_cast<char>('a' + move.to.col);
+  s += static_cast<char>('8' - move.to.row);
+  switch (move.promotion_piece) {
+    case PieceType::QUEEN: s += 'q'; break;
+    case PieceType::ROOK: s += 'r'; break;
+    case PieceType::BISHOP: s += 'b'; break;
+    case PieceType::KNIGHT: s += 'n'; break;
+    default: break;
+  }
+  return s;
+}
+
 inline Color string_to_color(const std::string& s) {
   return (s == "WHITE")? Color::WHITE : Color::BLACK;
 }
@@ -51,6 +75,22 @@ inline PieceType char_to_piece_type(char c) {
   }
 }
 
+// 子力分值 (厘兵), 供评估与走法排序共用; 王记为 0.
+constexpr int piece_value(PieceType type) {
+  switch (type) {
+    case PieceType::PAWN: return 100;
+    case PieceType::KNIGHT: return 320;
+    case PieceType::BISHOP: return 330;
+    case PieceType::ROOK: return 500;
+    case PieceType::QUEEN: return 900;
+    default: return 0;
+  }
+}
+
+inline bool is_empty_square(char c) {
+  return c == '.' || c == ' ';
+}
+
 inline Color get_piece_color(char c) {
   if (std::isspace(c) || c == '.' || c == ' ') {
     return Color::NONE;
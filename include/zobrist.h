@@ -0,0 +1,14 @@
+#pragma once
+
+#include "game_state.h"
+#include "types.h"
+#include <cstdint>
+
+// 键值由固定种子生成, 写入磁盘的索引在不同进程之间保持一致.
+uint64_t zobrist_piece_key(char piece, const Position& pos);
+uint64_t zobrist_castling_key(int castling_bit);
+uint64_t zobrist_en_passant_key(int col);
+uint64_t zobrist_side_key();
+
+uint64_t compute_position_key(const GameState& state);
+uint64_t compute_pawn_key(const GameState& state);
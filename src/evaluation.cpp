@@ -0,0 +1,177 @@
+#include "evaluation.h"
+
+namespace {
+
+const int kDoubledPenalty = 12;
+const int kIsolatedPenalty = 15;
+const int kBackwardPenalty = 10;
+const std::array<int, 8> kPassedBonus = {0, 5, 10, 20, 35, 60, 100, 0};
+
+const int kShieldNear = 12;
+const int kShieldFar = 6;
+const int kShieldMissing = -15;
+
+// 以各方自己的视角记录兵的行: 0 为己方底线, 7 为对方底线.
+struct PawnFiles {
+  std::array<std::array<bool, 8>, 8> has_pawn{};
+  std::array<int, 8> count{};
+  std::array<int, 8> least_advanced{};
+  std::array<int, 8> most_advanced{};
+};
+
+int relative_rank(Color color, int row) {
+  return (color == Color::WHITE) ? 7 - row : row;
+}
+
+int evaluate_side(const PawnFiles& us, const PawnFiles& them) {
+  int score = 0;
+  for (int col = 0; col < 8; ++col) {
+    if (us.count[col] == 0) continue;
+
+    if (us.count[col] > 1) {
+      score -= kDoubledPenalty * (us.count[col] - 1);
+    }
+
+    bool left = col > 0 && us.count[col - 1] > 0;
+    bool right = col < 7 && us.count[col + 1] > 0;
+    if (!left && !right) {
+      score -= kIsolatedPenalty * us.count[col];
+    }
+
+    for (int rank = 1; rank < 7; ++rank) {
+      if (!us.has_pawn[col][rank]) continue;
+
+      // 对方在本列及相邻列、且位于本兵前方的兵 (换算到我方视角为 7 - rank).
+      bool passed = true;
+      for (int c = col - 1; c <= col + 1 && passed; ++c) {
+        if (c < 0 || c > 7 || them.count[c] == 0) continue;
+        if (7 - them.least_advanced[c] > rank) passed = false;
+      }
+      if (passed && rank == us.most_advanced[col]) {
+        score += kPassedBonus[rank];
+      }
+
+      // 落后兵: 相邻列的己方兵都已越过它, 且前进格被对方兵控制.
+      if (left || right) {
+        bool supported = false;
+        for (int c = col - 1; c <= col + 1; c += 2) {
+          if (c < 0 || c > 7 || us.count[c] == 0) continue;
+          if (us.least_advanced[c] <= rank) supported = true;
+        }
+        bool stop_attacked = false;
+        int stop_rank = rank + 1;
+        int attacker_rank = 7 - (stop_rank + 1);
+        for (int c = col - 1; c <= col + 1; c += 2) {
+          if (c < 0 || c > 7 || attacker_rank < 0) continue;
+          if (them.has_pawn[c][attacker_rank]) stop_attacked = true;
+        }
+        if (!supported && stop_attacked) {
+          score -= kBackwardPenalty;
+        }
+      }
+    }
+  }
+  return score;
+}
+
+int shelter_score(const PawnFiles& us, int king_col) {
+  int score = 0;
+  for (int c = king_col - 1; c <= king_col + 1; ++c) {
+    if (c < 0 || c > 7) continue;
+    if (us.has_pawn[c][1]) {
+      score += kShieldNear;
+    } else if (us.has_pawn[c][2]) {
+      score += kShieldFar;
+    } else {
+      score += kShieldMissing;
+    }
+  }
+  return score;
+}
+
+}  // namespace
+
+PawnHashTable::PawnHashTable(size_t entry_count) {
+  size_t size = 1;
+  while (size < entry_count) size <<= 1;
+  entries_.resize(size);
+  mask_ = size - 1;
+}
+
+PawnEntry& PawnHashTable::probe(uint64_t key, bool& found) {
+  PawnEntry& entry = entries_[key & mask_];
+  ++probes_;
+  found = entry.valid && entry.key == key;
+  if (found) {
+    ++hits_;
+  }
+  return entry;
+}
+
+void evaluate_pawn_structure(const GameState& state, PawnEntry& entry) {
+  std::array<PawnFiles, 2> files;
+  for (auto& side : files) {
+    side.least_advanced.fill(8);
+    side.most_advanced.fill(-1);
+  }
+
+  for (int r = 0; r < 8; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      char piece = state.board_[r][c];
+      if (char_to_piece_type(piece) != PieceType::PAWN) continue;
+
+      Color color = get_piece_color(piece);
+      PawnFiles& side = files[color == Color::WHITE ? 0 : 1];
+      int rank = relative_rank(color, r);
+      side.has_pawn[c][rank] = true;
+      ++side.count[c];
+      if (rank < side.least_advanced[c]) side.least_advanced[c] = rank;
+      if (rank > side.most_advanced[c]) side.most_advanced[c] = rank;
+    }
+  }
+
+  entry.score = evaluate_side(files[0], files[1]) -
+                evaluate_side(files[1], files[0]);
+  for (int side = 0; side < 2; ++side) {
+    for (int col = 0; col < 8; ++col) {
+      entry.shelter[side][col] = shelter_score(files[side], col);
+    }
+  }
+}
+
+const PawnEntry& Evaluator::probe_pawns(const GameState& state) {
+  bool found = false;
+  PawnEntry& entry = pawn_table_.probe(state.pawn_key_, found);
+  if (!found) {
+    evaluate_pawn_structure(state, entry);
+    entry.key = state.pawn_key_;
+    entry.valid = true;
+  }
+  return entry;
+}
+
+int Evaluator::evaluate(const GameState& state) {
+  int score = 0;
+  for (int side = 0; side < 2; ++side) {
+    int sign = (side == 0) ? 1 : -1;
+    for (int i = 0; i < state.piece_count_[side]; ++i) {
+      int square = state.piece_squares_[side][i];
+      char piece = state.board_[square / 8][square % 8];
+      score += sign * piece_value(char_to_piece_type(piece));
+    }
+  }
+  Position white_king = state.king_square_[0];
+  Position black_king = state.king_square_[1];
+
+  const PawnEntry& pawns = probe_pawns(state);
+  score += pawns.score;
+
+  // 兵盾只在王仍留在底线附近时计入.
+  if (white_king.is_valid() && white_king.row >= 6) {
+    score += pawns.shelter[0][white_king.col];
+  }
+  if (black_king.is_valid() && black_king.row <= 1) {
+    score -= pawns.shelter[1][black_king.col];
+  }
+  return score;
+}
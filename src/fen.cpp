@@ -0,0 +1,107 @@
+#include "fen.h"
+#include "zobrist.h"
+#include <cctype>
+#include <sstream>
+
+std::optional<GameState> parse_fen(const std::string& fen) {
+  std::istringstream in(fen);
+  std::string placement, side, castling = "-", en_passant = "-";
+  if (!(in >> placement >> side)) {
+    return std::nullopt;
+  }
+  in >> castling >> en_passant;
+
+  GameState state;
+  int row = 0;
+  int col = 0;
+  for (char c : placement) {
+    if (c == '/') {
+      if (col != 8 || row == 7) return std::nullopt;
+      ++row;
+      col = 0;
+    } else if (std::isdigit(static_cast<unsigned char>(c))) {
+      int count = c - '0';
+      if (row > 7 || count < 1 || col + count > 8) return std::nullopt;
+      for (int i = 0; i < count; ++i) {
+        state.board_[row][col++] = '.';
+      }
+    } else {
+      if (char_to_piece_type(c) == PieceType::EMPTY) return std::nullopt;
+      if (row > 7 || col > 7) return std::nullopt;
+      state.board_[row][col++] = c;
+    }
+  }
+  if (row != 7 || col != 8) {
+    return std::nullopt;
+  }
+
+  int white_pieces = 0;
+  int black_pieces = 0;
+  for (const auto& rank : state.board_) {
+    for (char piece : rank) {
+      if (get_piece_color(piece) == Color::WHITE) ++white_pieces;
+      if (get_piece_color(piece) == Color::BLACK) ++black_pieces;
+    }
+  }
+  if (white_pieces > 16 || black_pieces > 16) {
+    return std::nullopt;
+  }
+  state.rebuild_piece_lists();
+
+  if (side == "w") {
+    state.active_color_ = Color::WHITE;
+  } else if (side == "b") {
+    state.active_color_ = Color::BLACK;
+  } else {
+    return std::nullopt;
+  }
+
+  auto& rights = state.castling_rights_;
+  rights.white_king_side_ = castling.find('K') != std::string::npos;
+  rights.white_queen_side_ = castling.find('Q') != std::string::npos;
+  rights.black_king_side_ = castling.find('k') != std::string::npos;
+  rights.black_queen_side_ = castling.find('q') != std::string::npos;
+
+  // 王和车不在原位时, 对应的易位权无效.
+  bool white_king_home = state.get_piece({7, 4}) == 'K';
+  bool black_king_home = state.get_piece({0, 4}) == 'k';
+  rights.white_king_side_ = rights.white_king_side_ && white_king_home &&
+                            state.get_piece({7, 7}) == 'R';
+  rights.white_queen_side_ = rights.white_queen_side_ && white_king_home &&
+                             state.get_piece({7, 0}) == 'R';
+  rights.black_king_side_ = rights.black_king_side_ && black_king_home &&
+                            state.get_piece({0, 7}) == 'r';
+  rights.black_queen_side_ = rights.black_queen_side_ && black_king_home &&
+                             state.get_piece({0, 0}) == 'r';
+
+  state.en_passant_target_ = std::nullopt;
+  if (en_passant != "-") {
+    if (en_passant.length() != 2) return std::nullopt;
+    Position target = {'8' - en_passant[1], en_passant[0] - 'a'};
+    if (!target.is_valid()) return std::nullopt;
+
+    // 只保留与棋盘一致的过路兵格: 位于第 6 (黑方行棋时第 3) 横线,
+    // 格子为空, 且其后方是刚走过两步的对方兵.
+    bool white_to_move = state.active_color_ == Color::WHITE;
+    int target_row = white_to_move ? 2 : 5;
+    int pawn_row = white_to_move ? 3 : 4;
+    char enemy_pawn = white_to_move ? 'p' : 'P';
+    if (target.row == target_row && is_empty_square(state.get_piece(target)) &&
+        state.get_piece({pawn_row, target.col}) == enemy_pawn) {
+      state.en_passant_target_ = target;
+    }
+  }
+
+  state.pawn_key_ = compute_pawn_key(state);
+
+  int half_move_clock = 0;
+  int fullmove_number = 1;
+  if (in >> half_move_clock >> fullmove_number) {
+    state.half_move_clock_ = half_move_clock;
+    state.fullmove_number_ = fullmove_number;
+  } else {
+    state.half_move_clock_ = 0;
+    state.fullmove_number_ = 1;
+  }
+  return state;
+}
@@ -1,8 +1,38 @@
 #include "game.h"
+#include "zobrist.h"
 #include <iostream>
 
+namespace {
+
+template <MoveGenType Type>
+constexpr bool gen_includes(bool is_capture) {
+  return Type == MoveGenType::ALL ||
+         (Type == MoveGenType::CAPTURES) == is_capture;
+}
+
+constexpr std::array<Position, 4> kRookDirections = {{
+    {0, 1}, {0, -1}, {1, 0}, {-1, 0}}};
+constexpr std::array<Position, 4> kBishopDirections = {{
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+constexpr std::array<Position, 8> kQueenDirections = {{
+    {1, 1}, {1, -1}, {-1, 1}, {-1, -1},
+    {0, 1}, {0, -1}, {1, 0}, {-1, 0}}};
+constexpr std::array<Position, 8> kKnightOffsets = {{
+    {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
+    {1, -2},  {1, 2},  {2, -1},  {2, 1}}};
+
+template <Color Us>
+constexpr bool is_enemy_piece(char c) {
+  return (Us == Color::WHITE)? (c >= 'a' && c <= 'z')
+                             : (c >= 'A' && c <= 'Z');
+}
+
+}  // namespace
+
 Game::Game() : game_state_(), cache_is_valid_(false) {}
 
+Game::Game(const GameState& state) : game_state_(state), cache_is_valid_(false) {}
+
 GameState Game::get_state() const {
   return game_state_;
 }
@@ -17,11 +47,7 @@ std::vector<Move> Game::get_all_legal_moves() const {
       generate_pseudo_legal_moves(game_state_);
 
   for (const auto& move : pseudo_moves) {
-    GameState temp_state = game_state_;
-    
-    make_temporary_move(temp_state, move);
-
-    if (!is_king_in_check(game_state_.active_color_, temp_state)) {
+    if (is_move_legal(game_state_, move)) {
       legal_moves.push_back(move);
     }
   }
@@ -31,6 +57,62 @@ std::vector<Move> Game::get_all_legal_moves() const {
   return legal_moves;
 }
 
+void Game::generate_moves(const GameState& state,
+                          MoveGenType type,
+                          std::vector<Move>& moves) const {
+  if (state.active_color_ == Color::WHITE) {
+    generate_moves<Color::WHITE>(state, type, moves);
+  } else {
+    generate_moves<Color::BLACK>(state, type, moves);
+  }
+}
+
+template <Color Us>
+void Game::generate_moves(const GameState& state,
+                          MoveGenType type,
+                          std::vector<Move>& moves) const {
+  switch (type) {
+    case MoveGenType::ALL:
+      generate_pseudo_legal_moves<Us, MoveGenType::ALL>(moves, state);
+      break;
+    case MoveGenType::CAPTURES:
+      generate_pseudo_legal_moves<Us, MoveGenType::CAPTURES>(moves, state);
+      break;
+    case MoveGenType::QUIETS:
+      generate_pseudo_legal_moves<Us, MoveGenType::QUIETS>(moves, state);
+      break;
+  }
+}
+
+bool Game::is_pseudo_legal(const GameState& state, const Move& move) const {
+  if (!move.from.is_valid() || !move.to.is_valid() ||
+      get_piece_color(state.get_piece(move.from)) != state.active_color_) {
+    return false;
+  }
+
+  std::vector<Move> moves;
+  if (state.active_color_ == Color::WHITE) {
+    generate_piece_moves<Color::WHITE, MoveGenType::ALL>(moves, state,
+                                                         move.from);
+  } else {
+    generate_piece_moves<Color::BLACK, MoveGenType::ALL>(moves, state,
+                                                         move.from);
+  }
+  for (const auto& candidate : moves) {
+    if (candidate == move &&
+        candidate.promotion_piece == move.promotion_piece) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Game::is_move_legal(const GameState& state, const Move& move) const {
+  GameState temp_state = state;
+  make_temporary_move(temp_state, move);
+  return !is_king_in_check(state.active_color_, temp_state);
+}
+
 bool Game::is_game_over() const {
   return get_all_legal_moves().empty();
 }
@@ -49,42 +131,61 @@ std::string Game::get_result() const {
 }
 
 void Game::make_move(const Move& move) {
-  make_temporary_move(game_state_, move);
+  apply_move(game_state_, move);
+  cache_is_valid_ = false;
+}
 
-  game_state_.active_color_ = (game_state_.active_color_ == Color::WHITE)
-                                   ? Color::BLACK
-                                    : Color::WHITE;
-  
-  if (game_state_.active_color_ == Color::WHITE) {
-    game_state_.fullmove_number_++;
+void Game::apply_move(GameState& state, const Move& move) const {
+  make_temporary_move(state, move);
+
+  state.active_color_ = (state.active_color_ == Color::WHITE)
+                            ? Color::BLACK
+                            : Color::WHITE;
+
+  if (state.active_color_ == Color::WHITE) {
+    state.fullmove_number_++;
   }
+}
 
-  cache_is_valid_ = false;
+bool Game::is_in_check(const GameState& state) const {
+  return is_king_in_check(state.active_color_, state);
 }
 
 
 void Game::make_temporary_move(GameState& state, const Move& move) const {
   char piece_moved = state.get_piece(move.from);
   char captured_piece = state.get_piece(move.to);
-
+  std::optional<Position> en_passant_target = state.en_passant_target_;
 
   state.en_passant_target_ = std::nullopt;
 
-  state.set_piece(move.to, piece_moved);
   state.set_piece(move.from, '.');
+  state.set_piece(move.to, piece_moved);
+
+  if (char_to_piece_type(captured_piece) == PieceType::PAWN) {
+    state.pawn_key_ ^= zobrist_piece_key(captured_piece, move.to);
+  }
 
   PieceType type = char_to_piece_type(piece_moved);
   if (type == PieceType::PAWN) {
+    state.pawn_key_ ^= zobrist_piece_key(piece_moved, move.from);
+    if (move.promotion_piece == PieceType::EMPTY) {
+      state.pawn_key_ ^= zobrist_piece_key(piece_moved, move.to);
+    }
+
     if (std::abs(move.from.row - move.to.row) == 2) {
       state.en_passant_target_ = Position{
           (move.from.row + move.to.row) / 2, move.from.col};
     }
 
-    else if (move.to == state.en_passant_target_) {
+    else if (move.to == en_passant_target) {
       int captured_pawn_row = (state.active_color_ == Color::WHITE)
                                  ? move.to.row + 1
                                   : move.to.row - 1;
-      state.set_piece(Position{captured_pawn_row, move.to.col}, '.');
+      Position captured_pawn = {captured_pawn_row, move.to.col};
+      state.pawn_key_ ^=
+          zobrist_piece_key(state.get_piece(captured_pawn), captured_pawn);
+      state.set_piece(captured_pawn, '.');
     }
 
     else if (move.promotion_piece!= PieceType::EMPTY) {
@@ -107,13 +208,15 @@ void Game::make_temporary_move(GameState& state, const Move& move) const {
     int row = move.from.row;
 
     if (move.from.col == 4 && move.to.col == 6) {
-      state.set_piece(Position{row, 5}, state.get_piece(Position{row, 7}));
+      char rook = state.get_piece(Position{row, 7});
       state.set_piece(Position{row, 7}, '.');
+      state.set_piece(Position{row, 5}, rook);
     }
 
     else if (move.from.col == 4 && move.to.col == 2) {
-      state.set_piece(Position{row, 3}, state.get_piece(Position{row, 0}));
+      char rook = state.get_piece(Position{row, 0});
       state.set_piece(Position{row, 0}, '.');
+      state.set_piece(Position{row, 3}, rook);
     }
   }
 
@@ -121,7 +224,7 @@ void Game::make_temporary_move(GameState& state, const Move& move) const {
   update_castling_rights(state, move, piece_moved);
 
 
-  if (type == PieceType::PAWN || captured_piece!= '.') {
+  if (type == PieceType::PAWN || !is_empty_square(captured_piece)) {
     state.half_move_clock_ = 0;
   } else {
     state.half_move_clock_++;
@@ -155,22 +258,45 @@ void Game::update_castling_rights(GameState& state,
   } else if (move.from.row == 0 && move.from.col == 0) {
     rights.black_queen_side_ = false;
   }
+
+  if (move.to.row == 7 && move.to.col == 7) {
+    rights.white_king_side_ = false;
+  } else if (move.to.row == 7 && move.to.col == 0) {
+    rights.white_queen_side_ = false;
+  } else if (move.to.row == 0 && move.to.col == 7) {
+    rights.black_king_side_ = false;
+  } else if (move.to.row == 0 && move.to.col == 0) {
+    rights.black_queen_side_ = false;
+  }
 }
 
 bool Game::is_square_attacked(const Position& pos,
                             Color attacker_color,
                             const GameState& state) const {
-  const std::vector<Position> rook_dirs = {{0, 1}, {0, -1}, {1, 0}, {-1, 0}};
-  const std::vector<Position> bish_dirs = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+  if (attacker_color == Color::WHITE) {
+    return is_square_attacked<Color::WHITE>(pos, state);
+  }
+  return is_square_attacked<Color::BLACK>(pos, state);
+}
 
-  for (const auto& dir : rook_dirs) {
+template <Color Attacker>
+bool Game::is_square_attacked(const Position& pos,
+                            const GameState& state) const {
+  constexpr char rook = colored_piece(Attacker, 'r');
+  constexpr char bishop = colored_piece(Attacker, 'b');
+  constexpr char queen = colored_piece(Attacker, 'q');
+  constexpr char knight = colored_piece(Attacker, 'n');
+  constexpr char pawn = colored_piece(Attacker, 'p');
+  constexpr char king = colored_piece(Attacker, 'k');
+  constexpr int dir = (Attacker == Color::WHITE)? 1 : -1;
+
+  for (const auto& d : kRookDirections) {
     for (int i = 1; ; ++i) {
-      Position p = {pos.row + dir.row * i, pos.col + dir.col * i};
+      Position p = {pos.row + d.row * i, pos.col + d.col * i};
       if (!p.is_valid()) break;
       char piece = state.get_piece(p);
-      if (piece!= '.') {
-        if (get_piece_color(piece) == attacker_color &&
-            (std::tolower(piece) == 'r' || std::tolower(piece) == 'q')) {
+      if (!is_empty_square(piece)) {
+        if (piece == rook || piece == queen) {
           return true;
         }
         break;
@@ -178,14 +304,13 @@ bool Game::is_square_attacked(const Position& pos,
     }
   }
 
-  for (const auto& dir : bish_dirs) {
+  for (const auto& d : kBishopDirections) {
     for (int i = 1; ; ++i) {
-      Position p = {pos.row + dir.row * i, pos.col + dir.col * i};
+      Position p = {pos.row + d.row * i, pos.col + d.col * i};
       if (!p.is_valid()) break;
       char piece = state.get_piece(p);
-      if (piece!= '.') {
-        if (get_piece_color(piece) == attacker_color &&
-            (std::tolower(piece) == 'b' || std::tolower(piece) == 'q')) {
+      if (!is_empty_square(piece)) {
+        if (piece == bishop || piece == queen) {
           return true;
         }
         break;
@@ -193,35 +318,21 @@ bool Game::is_square_attacked(const Position& pos,
     }
   }
 
-  const std::vector<Position> knight_moves = {
-      {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-      {1, -2},  {1, 2},  {2, -1},  {2, 1}};
-  for (const auto& move : knight_moves) {
-    Position p = {pos.row + move.row, pos.col + move.col};
-    if (p.is_valid() && get_piece_color(state.get_piece(p)) == attacker_color &&
-        std::tolower(state.get_piece(p)) == 'n') {
+  for (const auto& move : kKnightOffsets) {
+    if (state.get_piece({pos.row + move.row, pos.col + move.col}) == knight) {
       return true;
     }
   }
 
-  int dir = (attacker_color == Color::WHITE)? 1 : -1;
-  Position p1 = {pos.row + dir, pos.col + 1};
-  Position p2 = {pos.row + dir, pos.col - 1};
-  if (p1.is_valid() && get_piece_color(state.get_piece(p1)) == attacker_color &&
-      std::tolower(state.get_piece(p1)) == 'p') {
-    return true;
-  }
-  if (p2.is_valid() && get_piece_color(state.get_piece(p2)) == attacker_color &&
-      std::tolower(state.get_piece(p2)) == 'p') {
+  if (state.get_piece({pos.row + dir, pos.col + 1}) == pawn ||
+      state.get_piece({pos.row + dir, pos.col - 1}) == pawn) {
     return true;
   }
 
   for (int dr = -1; dr <= 1; ++dr) {
     for (int dc = -1; dc <= 1; ++dc) {
       if (dr == 0 && dc == 0) continue;
-      Position p = {pos.row + dr, pos.col + dc};
-      if (p.is_valid() && get_piece_color(state.get_piece(p)) == attacker_color &&
-          std::tolower(state.get_piece(p)) == 'k') {
+      if (state.get_piece({pos.row + dr, pos.col + dc}) == king) {
         return true;
       }
     }
@@ -231,200 +342,195 @@ bool Game::is_square_attacked(const Position& pos,
 }
 
 bool Game::is_king_in_check(Color color, const GameState& state) const {
-  Position king_pos;
-  char king_char = (color == Color::WHITE)? 'K' : 'k';
-  for (int r = 0; r < 8; ++r) {
-    for (int c = 0; c < 8; ++c) {
-      if (state.board_[r][c] == king_char) {
-        king_pos = {r, c};
-        break;
-      }
-    }
-  }
-
+  Position king_pos = state.king_square_[GameState::color_index(color)];
   if (!king_pos.is_valid()) {
     return false; 
   }
 
-  Color attacker_color = (color == Color::WHITE)? Color::BLACK : Color::WHITE;
-  return is_square_attacked(king_pos, attacker_color, state);
+  return is_square_attacked(king_pos, opposite_color(color), state);
 }
 
 std::vector<Move> Game::generate_pseudo_legal_moves(
     const GameState& state) const {
   std::vector<Move> moves;
-  Color my_color = state.active_color_;
-
-  for (int r = 0; r < 8; ++r) {
-    for (int c = 0; c < 8; ++c) {
-      Position from = {r, c};
-      char piece = state.get_piece(from);
-      if (piece == '.' || get_piece_color(piece)!= my_color) {
-        continue;
-      }
+  generate_moves(state, MoveGenType::ALL, moves);
+  return moves;
+}
 
-      switch (std::tolower(piece)) {
-        case 'p':
-          generate_pawn_moves(moves, state, from);
-          break;
-        case 'n':
-          generate_knight_moves(moves, state, from);
-          break;
-        case 'b':
-          generate_sliding_moves(
-              moves, state, from,
-              {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}});
-          break;
-        case 'r':
-          generate_sliding_moves(
-              moves, state, from,
-              {{0, 1}, {0, -1}, {1, 0}, {-1, 0}}); 
-          break;
-        case 'q':
-          generate_sliding_moves(
-              moves, state, from,
-              {{1, 1}, {1, -1}, {-1, 1}, {-1, -1},
-               {0, 1}, {0, -1}, {1, 0}, {-1, 0}});
-          break;
-        case 'k':
-          generate_king_moves(moves, state, from);
-          break;
-      }
-    }
+template <Color Us, MoveGenType Type>
+void Game::generate_pseudo_legal_moves(std::vector<Move>& moves,
+                                       const GameState& state) const {
+  constexpr int side = (Us == Color::WHITE)? 0 : 1;
+  for (int i = 0; i < state.piece_count_[side]; ++i) {
+    int square = state.piece_squares_[side][i];
+    generate_piece_moves<Us, Type>(moves, state, {square / 8, square % 8});
+  }
+}
+
+template <Color Us, MoveGenType Type>
+void Game::generate_piece_moves(std::vector<Move>& moves,
+                                const GameState& state,
+                                const Position& from) const {
+  switch (state.get_piece(from)) {
+    case colored_piece(Us, 'p'):
+      generate_pawn_moves<Us, Type>(moves, state, from);
+      break;
+    case colored_piece(Us, 'n'):
+      generate_knight_moves<Us, Type>(moves, state, from);
+      break;
+    case colored_piece(Us, 'b'):
+      generate_sliding_moves<Us, Type>(moves, state, from, kBishopDirections);
+      break;
+    case colored_piece(Us, 'r'):
+      generate_sliding_moves<Us, Type>(moves, state, from, kRookDirections);
+      break;
+    case colored_piece(Us, 'q'):
+      generate_sliding_moves<Us, Type>(moves, state, from, kQueenDirections);
+      break;
+    case colored_piece(Us, 'k'):
+      generate_king_moves<Us, Type>(moves, state, from);
+      break;
   }
-  return moves;
 }
 
+template <Color Us, MoveGenType Type>
 void Game::add_move(std::vector<Move>& moves,
                 const GameState& state,
                 const Position& from,
-                const Position& to,
-                bool is_capture) const {
-  char piece = state.get_piece(from);
-  Color color = get_piece_color(piece);
-  
-  if (to.is_valid()) {
-    char target_piece = state.get_piece(to);
-    Color target_color = get_piece_color(target_piece);
-
-    if (is_capture) {
-      if (target_color == color) return;
-      if (target_color == Color::NONE) return;
-    } else {
-      if (target_color!= Color::NONE) return;
-    }
+                const Position& to) const {
+  if (!to.is_valid()) {
+    return;
+  }
 
-    int promotion_row = (color == Color::WHITE)? 0 : 7;
-    if (std::tolower(piece) == 'p' && to.row == promotion_row) {
-      moves.push_back({from, to, PieceType::QUEEN});
-      moves.push_back({from, to, PieceType::ROOK});
-      moves.push_back({from, to, PieceType::BISHOP});
-      moves.push_back({from, to, PieceType::KNIGHT});
-    } else {
+  char target_piece = state.get_piece(to);
+  if (is_empty_square(target_piece)) {
+    if (gen_includes<Type>(false)) {
       moves.push_back({from, to});
     }
+  } else if (gen_includes<Type>(true) && is_enemy_piece<Us>(target_piece)) {
+    moves.push_back({from, to});
   }
 }
 
+template <Color Us, MoveGenType Type>
 void Game::generate_pawn_moves(std::vector<Move>& moves,
                            const GameState& state,
                            const Position& from) const {
-  Color color = state.active_color_;
-  int dir = (color == Color::WHITE)? -1 : 1;
-  int start_row = (color == Color::WHITE)? 6 : 1;
+  constexpr int dir = (Us == Color::WHITE)? -1 : 1;
+  constexpr int start_row = (Us == Color::WHITE)? 6 : 1;
+  constexpr int promotion_row = (Us == Color::WHITE)? 0 : 7;
+
+  auto push = [&](const Position& to) {
+    if (to.row == promotion_row) {
+      moves.push_back({from, to, PieceType::QUEEN});
+      moves.push_back({from, to, PieceType::ROOK});
+      moves.push_back({from, to, PieceType::BISHOP});
+      moves.push_back({from, to, PieceType::KNIGHT});
+    } else {
+      moves.push_back({from, to});
+    }
+  };
 
   Position one_step = {from.row + dir, from.col};
-  if (one_step.is_valid() && state.get_piece(one_step) == '.') {
-    add_move(moves, state, from, one_step, false);
+  bool promotes = one_step.row == promotion_row;
+  if (gen_includes<Type>(promotes) && one_step.is_valid() &&
+      is_empty_square(state.get_piece(one_step))) {
+    push(one_step);
 
     if (from.row == start_row) {
       Position two_steps = {from.row + 2 * dir, from.col};
-      if (two_steps.is_valid() && state.get_piece(two_steps) == '.') {
-        add_move(moves, state, from, two_steps, false);
+      if (is_empty_square(state.get_piece(two_steps))) {
+        push(two_steps);
       }
     }
   }
 
+  if (!gen_includes<Type>(true)) {
+    return;
+  }
+
   Position cap_left = {from.row + dir, from.col - 1};
   Position cap_right = {from.row + dir, from.col + 1};
-  if (cap_left.is_valid() && state.get_piece(cap_left)!= '.' &&
-      get_piece_color(state.get_piece(cap_left))!= color) {
-    add_move(moves, state, from, cap_left, true);
+  if (is_enemy_piece<Us>(state.get_piece(cap_left))) {
+    push(cap_left);
   }
-  if (cap_right.is_valid() && state.get_piece(cap_right)!= '.' &&
-      get_piece_color(state.get_piece(cap_right))!= color) {
-    add_move(moves, state, from, cap_right, true);
+  if (is_enemy_piece<Us>(state.get_piece(cap_right))) {
+    push(cap_right);
   }
 
   if (state.en_passant_target_) {
     Position target = *state.en_passant_target_;
     if (target == cap_left || target == cap_right) {
-      add_move(moves, state, from, target, true);
+      moves.push_back({from, target});
     }
   }
 }
 
+template <Color Us, MoveGenType Type>
 void Game::generate_knight_moves(std::vector<Move>& moves,
                              const GameState& state,
                              const Position& from) const {
-  const std::vector<Position> knight_moves = {
-      {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2},
-      {1, -2},  {1, 2},  {2, -1},  {2, 1}};
-  for (const auto& move : knight_moves) {
-    Position to = {from.row + move.row, from.col + move.col};
-    add_move(moves, state, from, to, true);
+  for (const auto& move : kKnightOffsets) {
+    add_move<Us, Type>(moves, state, from,
+                       {from.row + move.row, from.col + move.col});
   }
 }
 
+template <Color Us, MoveGenType Type>
 void Game::generate_king_moves(std::vector<Move>& moves,
                            const GameState& state,
                            const Position& from) const {
   for (int dr = -1; dr <= 1; ++dr) {
     for (int dc = -1; dc <= 1; ++dc) {
       if (dr == 0 && dc == 0) continue;
-      Position to = {from.row + dr, from.col + dc};
-      add_move(moves, state, from, to, true);
+      add_move<Us, Type>(moves, state, from, {from.row + dr, from.col + dc});
     }
   }
 
-  Color color = state.active_color_;
+  if (!gen_includes<Type>(false)) {
+    return;
+  }
+
+  constexpr Color them = opposite_color(Us);
+  constexpr int row = (Us == Color::WHITE)? 7 : 0;
   const auto& rights = state.castling_rights_;
-  
-  if (is_king_in_check(color, state)) {
+  bool king_side = (Us == Color::WHITE)? rights.white_king_side_
+                                        : rights.black_king_side_;
+  bool queen_side = (Us == Color::WHITE)? rights.white_queen_side_
+                                         : rights.black_queen_side_;
+
+  if ((!king_side && !queen_side) || is_square_attacked<them>(from, state)) {
     return;
   }
-  
-  
-  int row = (color == Color::WHITE)? 7 : 0;
-  Color enemy_color = (color == Color::WHITE)? Color::BLACK : Color::WHITE;
-
-  if ((color == Color::WHITE && rights.white_king_side_) ||
-      (color == Color::BLACK && rights.black_king_side_)) {
-    if (state.get_piece({row, 5}) == '.' && state.get_piece({row, 6}) == '.') {
-      if (!is_square_attacked({row, 5}, enemy_color, state) &&
-         !is_square_attacked({row, 6}, enemy_color, state)) {
-        add_move(moves, state, from, {row, 6}, false);
+
+  if (king_side) {
+    if (is_empty_square(state.get_piece({row, 5})) &&
+        is_empty_square(state.get_piece({row, 6}))) {
+      if (!is_square_attacked<them>({row, 5}, state) &&
+         !is_square_attacked<them>({row, 6}, state)) {
+        moves.push_back({from, {row, 6}});
       }
     }
   }
 
-  if ((color == Color::WHITE && rights.white_queen_side_) ||
-      (color == Color::BLACK && rights.black_queen_side_)) {
-    if (state.get_piece({row, 1}) == '.' && state.get_piece({row, 2}) == '.' &&
-        state.get_piece({row, 3}) == '.') {
-      if (!is_square_attacked({row, 2}, enemy_color, state) &&
-         !is_square_attacked({row, 3}, enemy_color, state)) {
-        add_move(moves, state, from, {row, 2}, false);
+  if (queen_side) {
+    if (is_empty_square(state.get_piece({row, 1})) &&
+        is_empty_square(state.get_piece({row, 2})) &&
+        is_empty_square(state.get_piece({row, 3}))) {
+      if (!is_square_attacked<them>({row, 2}, state) &&
+         !is_square_attacked<them>({row, 3}, state)) {
+        moves.push_back({from, {row, 2}});
       }
     }
   }
 }
 
+template <Color Us, MoveGenType Type, size_t N>
 void Game::generate_sliding_moves(
     std::vector<Move>& moves,
     const GameState& state,
     const Position& from,
-    const std::vector<Position>& directions) const {
+    const std::array<Position, N>& directions) const {
   for (const auto& dir : directions) {
     for (int i = 1; ; ++i) {
       Position to = {from.row + dir.row * i, from.col + dir.col * i};
@@ -433,13 +539,15 @@ void Game::generate_sliding_moves(
       }
       
       char target_piece = state.get_piece(to);
-      if (target_piece!= '.') {
-        if (get_piece_color(target_piece)!= state.active_color_) {
-          add_move(moves, state, from, to, true); 
+      if (!is_empty_square(target_piece)) {
+        if (gen_includes<Type>(true) && is_enemy_piece<Us>(target_piece)) {
+          moves.push_back({from, to});
         }
         break;
       }
-      add_move(moves, state, from, to, false); 
+      if (gen_includes<Type>(false)) {
+        moves.push_back({from, to});
+      }
     }
   }
 }
\ No newline at end of file
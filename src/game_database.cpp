@@ -0,0 +1,305 @@
+#include "game_database.h"
+#include "fen.h"
+#include "game.h"
+#include "pgn.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const char kGamesMagic[8] = {'C', 'C', 'D', 'B', 'G', 'M', 'S', '2'};
+const char kIndexMagic[8] = {'C', 'C', 'D', 'B', 'I', 'D', 'X', '1'};
+const size_t kBatchSize = 4096;
+
+template <typename T>
+void write_pod(std::ofstream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_array(std::ofstream& out, const std::vector<T>& values) {
+  out.write(reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+}  // namespace
+
+uint16_t encode_move(const Move& move) {
+  int from = move.from.row * 8 + move.from.col;
+  int to = move.to.row * 8 + move.to.col;
+  return static_cast<uint16_t>(from | (to << 6) |
+                               (static_cast<int>(move.promotion_piece) << 12));
+}
+
+Move decode_move(uint16_t code) {
+  Move move;
+  move.from = {(code & 63) / 8, (code & 63) % 8};
+  move.to = {((code >> 6) & 63) / 8, ((code >> 6) & 63) % 8};
+  move.promotion_piece = static_cast<PieceType>(code >> 12);
+  return move;
+}
+
+GameDatabaseBuilder::GameDatabaseBuilder(unsigned thread_count)
+    : thread_count_(std::max(1u, thread_count)),
+      move_offsets_{0},
+      fen_offsets_{0} {}
+
+bool GameDatabaseBuilder::add_pgn_file(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+
+  PgnReader reader(in);
+  std::vector<std::string> batch;
+  std::string text;
+  while (reader.read_game_text(text)) {
+    batch.push_back(std::move(text));
+    if (batch.size() == kBatchSize) {
+      ingest_batch(batch);
+      batch.clear();
+    }
+  }
+  ingest_batch(batch);
+  return true;
+}
+
+GameDatabaseBuilder::ReplayResult GameDatabaseBuilder::replay_game(
+    const std::string& game_text) {
+  ReplayResult result;
+  PgnGame pgn = parse_pgn_game(game_text);
+
+  GameState start;
+  auto fen = pgn.tags.find("FEN");
+  if (fen != pgn.tags.end()) {
+    std::optional<GameState> parsed = parse_fen(fen->second);
+    if (!parsed) {
+      return result;
+    }
+    start = *parsed;
+    result.start_fen = fen->second;
+  }
+
+  Game game(start);
+  result.moves.reserve(pgn.san_moves.size());
+  result.keys.reserve(pgn.san_moves.size() + 1);
+  for (const auto& san : pgn.san_moves) {
+    GameState state = game.get_state();
+    std::optional<Move> move =
+        san_to_move(san, state, game.get_all_legal_moves());
+    if (!move) {
+      return result;
+    }
+    result.keys.push_back(compute_position_key(state));
+    result.moves.push_back(encode_move(*move));
+    game.make_move(*move);
+  }
+  result.keys.push_back(compute_position_key(game.get_state()));
+  result.ok = true;
+  return result;
+}
+
+void GameDatabaseBuilder::ingest_batch(
+    const std::vector<std::string>& game_texts) {
+  std::vector<ReplayResult> results(game_texts.size());
+  std::atomic<size_t> next_game{0};
+
+  auto worker = [&]() {
+    for (size_t i = next_game++; i < game_texts.size(); i = next_game++) {
+      results[i] = replay_game(game_texts[i]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < thread_count_; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto& result : results) {
+    if (!result.ok) {
+      ++rejected_count_;
+      continue;
+    }
+    uint32_t game_id = static_cast<uint32_t>(game_count());
+    for (size_t ply = 0; ply < result.keys.size(); ++ply) {
+      entries_.push_back(
+          {result.keys[ply], game_id, static_cast<uint32_t>(ply)});
+    }
+    moves_.insert(moves_.end(), result.moves.begin(), result.moves.end());
+    move_offsets_.push_back(moves_.size());
+    fens_ += result.start_fen;
+    fen_offsets_.push_back(fens_.size());
+  }
+}
+
+bool GameDatabaseBuilder::write(const std::string& directory) {
+  std::ofstream games(directory + "/games.bin", std::ios::binary);
+  if (!games) {
+    return false;
+  }
+  games.write(kGamesMagic, sizeof(kGamesMagic));
+  write_pod(games, static_cast<uint64_t>(game_count()));
+  write_array(games, move_offsets_);
+  write_array(games, fen_offsets_);
+  write_array(games, moves_);
+  games.write(fens_.data(), static_cast<std::streamsize>(fens_.size()));
+  if (!games) {
+    return false;
+  }
+
+  std::sort(entries_.begin(), entries_.end(),
+            [](const IndexEntry& a, const IndexEntry& b) {
+              if (a.key != b.key) return a.key < b.key;
+              if (a.game_id != b.game_id) return a.game_id < b.game_id;
+              return a.ply < b.ply;
+            });
+  if (entries_.size() > UINT32_MAX) {
+    return false;
+  }
+
+  size_t unique_keys = 0;
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (i == 0 || entries_[i].key != entries_[i - 1].key) ++unique_keys;
+  }
+
+  // 负载因子不超过 1/2, 保证线性探测的查找长度很短.
+  uint64_t slot_count = 1;
+  while (slot_count < unique_keys * 2) {
+    slot_count <<= 1;
+  }
+
+  std::vector<PositionIndexSlot> slots(slot_count,
+                                       PositionIndexSlot{0, 0, 0});
+  std::vector<PositionHit> postings(entries_.size());
+
+  for (size_t i = 0; i < entries_.size();) {
+    size_t j = i;
+    while (j < entries_.size() && entries_[j].key == entries_[i].key) {
+      postings[j] = {entries_[j].game_id, entries_[j].ply};
+      ++j;
+    }
+    uint64_t slot = entries_[i].key & (slot_count - 1);
+    while (slots[slot].count != 0) {
+      slot = (slot + 1) & (slot_count - 1);
+    }
+    slots[slot] = {entries_[i].key, static_cast<uint32_t>(i),
+                   static_cast<uint32_t>(j - i)};
+    i = j;
+  }
+
+  std::ofstream index(directory + "/index.bin", std::ios::binary);
+  if (!index) {
+    return false;
+  }
+  index.write(kIndexMagic, sizeof(kIndexMagic));
+  write_pod(index, slot_count);
+  write_pod(index, static_cast<uint64_t>(postings.size()));
+  write_array(index, slots);
+  write_array(index, postings);
+  return static_cast<bool>(index);
+}
+
+bool GameDatabase::open(const std::string& directory) {
+  if (!games_file_.open(directory + "/games.bin") ||
+      !index_file_.open(directory + "/index.bin")) {
+    return false;
+  }
+
+  const unsigned char* games = games_file_.data();
+  if (games_file_.size() < 16 ||
+      std::memcmp(games, kGamesMagic, sizeof(kGamesMagic)) != 0) {
+    return false;
+  }
+  std::memcpy(&game_count_, games + 8, sizeof(game_count_));
+  size_t table_size = (game_count_ + 1) * sizeof(uint64_t);
+  size_t moves_begin = 16 + 2 * table_size;
+  if (games_file_.size() < moves_begin) {
+    return false;
+  }
+  move_offsets_ = reinterpret_cast<const uint64_t*>(games + 16);
+  fen_offsets_ = reinterpret_cast<const uint64_t*>(games + 16 + table_size);
+  moves_ = reinterpret_cast<const uint16_t*>(games + moves_begin);
+  size_t fens_begin =
+      moves_begin + move_offsets_[game_count_] * sizeof(uint16_t);
+  if (games_file_.size() < fens_begin + fen_offsets_[game_count_]) {
+    return false;
+  }
+  fens_ = reinterpret_cast<const char*>(games + fens_begin);
+
+  const unsigned char* index = index_file_.data();
+  if (index_file_.size() < 24 ||
+      std::memcmp(index, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+    return false;
+  }
+  uint64_t slot_count = 0;
+  uint64_t posting_count = 0;
+  std::memcpy(&slot_count, index + 8, sizeof(slot_count));
+  std::memcpy(&posting_count, index + 16, sizeof(posting_count));
+  if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+      index_file_.size() < 24 + slot_count * sizeof(PositionIndexSlot) +
+                               posting_count * sizeof(PositionHit)) {
+    return false;
+  }
+  slot_mask_ = slot_count - 1;
+  slots_ = reinterpret_cast<const PositionIndexSlot*>(index + 24);
+  postings_ = reinterpret_cast<const PositionHit*>(
+      index + 24 + slot_count * sizeof(PositionIndexSlot));
+  return true;
+}
+
+PositionHits GameDatabase::find(uint64_t key) const {
+  if (slots_ == nullptr) {
+    return {};
+  }
+  for (uint64_t slot = key & slot_mask_; slots_[slot].count != 0;
+       slot = (slot + 1) & slot_mask_) {
+    if (slots_[slot].key == key) {
+      return {postings_ + slots_[slot].first, slots_[slot].count};
+    }
+  }
+  return {};
+}
+
+std::optional<GameState> GameDatabase::game_start(uint32_t game_id) const {
+  if (game_id >= game_count_) {
+    return std::nullopt;
+  }
+  uint64_t begin = fen_offsets_[game_id];
+  uint64_t end = fen_offsets_[game_id + 1];
+  if (begin == end) {
+    return GameState();
+  }
+  return parse_fen(std::string(fens_ + begin, fens_ + end));
+}
+
+std::vector<Move> GameDatabase::game_moves(uint32_t game_id) const {
+  std::vector<Move> moves;
+  if (game_id >= game_count_) {
+    return moves;
+  }
+  for (uint64_t i = move_offsets_[game_id]; i < move_offsets_[game_id + 1];
+       ++i) {
+    moves.push_back(decode_move(moves_[i]));
+  }
+  return moves;
+}
+
+std::optional<Move> GameDatabase::move_at(uint32_t game_id,
+                                          uint32_t ply) const {
+  if (game_id >= game_count_) {
+    return std::nullopt;
+  }
+  uint64_t index = move_offsets_[game_id] + ply;
+  if (index >= move_offsets_[game_id + 1]) {
+    return std::nullopt;
+  }
+  return decode_move(moves_[index]);
+}
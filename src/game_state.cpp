@@ -1,4 +1,5 @@
 #include "game_state.h"
+#include "zobrist.h"
 
 GameState::GameState() {
   board_ = {{
@@ -17,4 +18,19 @@ GameState::GameState() {
   en_passant_target_ = std::nullopt;
   half_move_clock_ = 0;
   fullmove_number_ = 1;
+  pawn_key_ = compute_pawn_key(*this);
+  rebuild_piece_lists();
+}
+
+void GameState::rebuild_piece_lists() {
+  piece_count_ = {0, 0};
+  piece_index_.fill(-1);
+  king_square_ = {Position{}, Position{}};
+  for (int r = 0; r < 8; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      if (!is_empty_square(board_[r][c])) {
+        add_to_list(board_[r][c], {r, c});
+      }
+    }
+  }
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+  close();
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    CloseHandle(file);
+    return false;
+  }
+
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  file_handle_ = file;
+  mapping_handle_ = mapping;
+  data_ = static_cast<const unsigned char*>(view);
+  size_ = static_cast<size_t>(file_size.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+    CloseHandle(file_handle_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  file_handle_ = nullptr;
+  mapping_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    ::close(fd);
+    return false;
+  }
+
+  void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                    MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (view == MAP_FAILED) {
+    return false;
+  }
+
+  data_ = static_cast<const unsigned char*>(view);
+  size_ = static_cast<size_t>(st.st_size);
+  return true;
+}
+
+void MappedFile::close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<unsigned char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif
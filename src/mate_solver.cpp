@@ -0,0 +1,259 @@
+#include "mate_solver.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <chrono>
+
+// phi / delta 约定: 对行棋方而言 phi 为 "证明我方获胜" 所需的代价.
+// 进攻方节点 phi = pn, delta = dn; 防守方节点 phi = dn, delta = pn.
+// 因此 phi(n) = min delta(c), delta(n) = sum phi(c).
+
+namespace {
+
+const uint64_t kInfinity = 1ULL << 40;
+
+uint64_t saturating_add(uint64_t a, uint64_t b) {
+  return std::min(kInfinity, a + b);
+}
+
+}  // namespace
+
+MateSolver::MateSolver(size_t table_megabytes) {
+  size_t wanted = std::max<size_t>(1, table_megabytes) * 1024 * 1024 /
+                  sizeof(TableEntry);
+  size_t size = 1;
+  while (size * 2 <= wanted || size < 2) size <<= 1;
+  table_.resize(size);
+  mask_ = size - 1;
+}
+
+uint64_t MateSolver::node_key(const GameState& state, int remaining) {
+  return compute_position_key(state) ^
+         (static_cast<uint64_t>(remaining + 1) * 0x9E3779B97F4A7C15ULL);
+}
+
+MateSolver::TableEntry MateSolver::lookup(uint64_t key) const {
+  size_t bucket = key & mask_ & ~static_cast<uint64_t>(1);
+  for (size_t i = bucket; i < bucket + 2; ++i) {
+    if (table_[i].work != 0 && table_[i].key == key) {
+      return table_[i];
+    }
+  }
+  TableEntry fresh;
+  fresh.key = key;
+  return fresh;
+}
+
+// 每个桶两个条目. 新结果总是写入 (否则父节点会反复展开同一子节点),
+// 需要腾位置时淘汰工作量较小的那个.
+void MateSolver::store(const TableEntry& entry) {
+  size_t bucket = entry.key & mask_ & ~static_cast<uint64_t>(1);
+  TableEntry* victim = &table_[bucket];
+  for (size_t i = bucket; i < bucket + 2; ++i) {
+    if (table_[i].key == entry.key || table_[i].work == 0) {
+      victim = &table_[i];
+      break;
+    }
+    if (table_[i].work < victim->work) {
+      victim = &table_[i];
+    }
+  }
+  *victim = entry;
+}
+
+std::vector<MateSolver::Child> MateSolver::expand(const GameState& state,
+                                                  int remaining) const {
+  std::vector<Move> moves;
+  game_.generate_moves(state, MoveGenType::ALL, moves);
+
+  std::vector<Child> children;
+  children.reserve(moves.size());
+  for (const auto& move : moves) {
+    if (!game_.is_move_legal(state, move)) continue;
+    Child child{move, state, 0, false};
+    game_.apply_move(child.state, move);
+    child.key = node_key(child.state, remaining - 1);
+    child.gives_check = game_.is_in_check(child.state);
+    children.push_back(child);
+  }
+
+  // 进攻方先试将军的走法.
+  bool attacker = remaining % 2 == 1;
+  if (attacker) {
+    std::stable_partition(children.begin(), children.end(),
+                          [](const Child& child) { return child.gives_check; });
+  }
+  return children;
+}
+
+void MateSolver::mid(const GameState& state, uint64_t key, int remaining,
+                     uint64_t threshold_phi, uint64_t threshold_delta) {
+  ++nodes_;
+  if (node_limit_ != 0 && nodes_ > node_limit_) {
+    aborted_ = true;
+    return;
+  }
+
+  TableEntry entry = lookup(key);
+  uint64_t work_before = nodes_;
+
+  if (remaining == 0) {
+    // 步数用完: 只有防守方此时已被将死才算证明成功.
+    bool mated = !has_legal_move(state) && game_.is_in_check(state);
+    entry.phi = mated ? kInfinity : 0;
+    entry.delta = mated ? 0 : kInfinity;
+    entry.proof_length = 0;
+    entry.work = 1;
+    store(entry);
+    return;
+  }
+
+  std::vector<Child> children = expand(state, remaining);
+  if (children.empty()) {
+    // 无子可走: 被将死则行棋方输, 逼和则对进攻方不利.
+    bool mated = game_.is_in_check(state);
+    bool attacker = remaining % 2 == 1;
+    bool side_to_move_wins = !mated && !attacker;
+    entry.phi = side_to_move_wins ? 0 : kInfinity;
+    entry.delta = side_to_move_wins ? kInfinity : 0;
+    entry.proof_length = 0;
+    entry.work = 1;
+    store(entry);
+    return;
+  }
+
+  bool attacker = remaining % 2 == 1;
+  while (!aborted_) {
+    uint64_t phi = kInfinity;
+    uint64_t delta = 0;
+    uint64_t second_delta = kInfinity;
+    size_t best = 0;
+    uint64_t best_phi = 0;
+    int proof_length = attacker ? remaining + 1 : 0;
+
+    for (size_t i = 0; i < children.size(); ++i) {
+      TableEntry child = lookup(children[i].key);
+      if (child.work == 0 && attacker && !children[i].gives_check) {
+        // 未展开的非将军走法初始代价略高, 让将军走法先被展开.
+        child.delta = 2;
+      }
+      if (child.delta < phi) {
+        second_delta = phi;
+        phi = child.delta;
+        best = i;
+        best_phi = child.phi;
+      } else if (child.delta < second_delta) {
+        second_delta = child.delta;
+      }
+      delta = saturating_add(delta, child.phi);
+
+      if (attacker && child.delta == 0) {
+        proof_length = std::min(proof_length, child.proof_length + 1);
+      } else if (!attacker) {
+        proof_length = std::max(proof_length, child.proof_length + 1);
+      }
+    }
+
+    if (phi >= threshold_phi || delta >= threshold_delta) {
+      entry.phi = phi;
+      entry.delta = delta;
+      entry.proof_length = proof_length;
+      entry.work = nodes_ - work_before + 1;
+      store(entry);
+      return;
+    }
+
+    uint64_t child_threshold_phi =
+        std::min(kInfinity, threshold_delta + best_phi - delta);
+    uint64_t child_threshold_delta =
+        std::min(threshold_phi, saturating_add(second_delta, 1));
+    mid(children[best].state, children[best].key, remaining - 1,
+        child_threshold_phi, child_threshold_delta);
+  }
+}
+
+bool MateSolver::has_legal_move(const GameState& state) const {
+  std::vector<Move> moves;
+  game_.generate_moves(state, MoveGenType::ALL, moves);
+  for (const auto& move : moves) {
+    if (game_.is_move_legal(state, move)) return true;
+  }
+  return false;
+}
+
+bool MateSolver::prove(const GameState& state, int remaining) {
+  uint64_t key = node_key(state, remaining);
+  mid(state, key, remaining, kInfinity, kInfinity);
+  TableEntry entry = lookup(key);
+  bool attacker = remaining % 2 == 1;
+  return attacker ? entry.phi == 0 : entry.delta == 0;
+}
+
+bool MateSolver::extract_line(const GameState& root, int remaining,
+                              std::vector<Move>& line) {
+  GameState state = root;
+  while (remaining > 0 && !aborted_) {
+    std::vector<Child> children = expand(state, remaining);
+    if (children.empty()) {
+      break;
+    }
+
+    bool attacker = remaining % 2 == 1;
+    const Child* chosen = nullptr;
+    int chosen_length = 0;
+    // 进攻方只需一个已证明的走法, 先查表; 表中结果被覆盖时才重新证明.
+    // 防守方则选坚持最久的应着, 每个应着都必须是已证明的.
+    for (int pass = 0; pass < 2 && chosen == nullptr; ++pass) {
+      for (const auto& child : children) {
+        TableEntry entry = lookup(child.key);
+        bool proven = attacker ? entry.delta == 0 : entry.phi == 0;
+        if (!proven && (attacker ? pass == 1 : true)) {
+          if (!prove(child.state, remaining - 1)) continue;
+          entry = lookup(child.key);
+          proven = true;
+        }
+        if (!proven) continue;
+        if (chosen == nullptr ||
+            (attacker ? entry.proof_length < chosen_length
+                      : entry.proof_length > chosen_length)) {
+          chosen = &child;
+          chosen_length = entry.proof_length;
+        }
+        if (attacker && pass == 1) break;
+      }
+    }
+    if (chosen == nullptr) {
+      break;
+    }
+    line.push_back(chosen->move);
+    state = chosen->state;
+    --remaining;
+  }
+  // 重新证明被覆盖的子节点可能耗尽节点上限, 此时解线在中途截断.
+  return !aborted_ && game_.is_in_check(state) && !has_legal_move(state);
+}
+
+MateResult MateSolver::solve(const GameState& root, int max_moves,
+                             uint64_t node_limit) {
+  MateResult result;
+  nodes_ = 0;
+  node_limit_ = node_limit;
+  aborted_ = false;
+  std::fill(table_.begin(), table_.end(), TableEntry());
+
+  auto start = std::chrono::steady_clock::now();
+  for (int moves = 1; moves <= max_moves && !aborted_; ++moves) {
+    int plies = 2 * moves - 1;
+    if (prove(root, plies)) {
+      result.found = true;
+      result.mate_in = moves;
+      result.line_complete = extract_line(root, plies, result.line);
+      break;
+    }
+  }
+
+  result.aborted = aborted_;
+  result.nodes = nodes_;
+  result.seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+  return result;
+}
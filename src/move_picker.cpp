@@ -0,0 +1,122 @@
+#include "move_picker.h"
+
+namespace {
+
+bool same_move(const Move& a, const Move& b) {
+  return a == b && a.promotion_piece == b.promotion_piece;
+}
+
+}  // namespace
+
+MovePicker::MovePicker(const Game& game,
+                       const GameState& state,
+                       std::optional<Move> hash_move,
+                       const std::array<Move, 2>& killers)
+    : game_(game), state_(state), hash_move_(hash_move), killers_(killers) {
+  if (hash_move_ && !game_.is_pseudo_legal(state_, *hash_move_)) {
+    hash_move_ = std::nullopt;
+  }
+}
+
+std::optional<Move> MovePicker::next() {
+  switch (stage_) {
+    case Stage::HASH_MOVE:
+      stage_ = Stage::GENERATE_CAPTURES;
+      if (hash_move_) {
+        return hash_move_;
+      }
+      [[fallthrough]];
+
+    case Stage::GENERATE_CAPTURES: {
+      std::vector<Move> moves;
+      game_.generate_moves(state_, MoveGenType::CAPTURES, moves);
+      captures_.reserve(moves.size());
+      for (const auto& move : moves) {
+        captures_.push_back({move, capture_score(move)});
+      }
+      current_ = 0;
+      stage_ = Stage::CAPTURES;
+      [[fallthrough]];
+    }
+
+    case Stage::CAPTURES:
+      // 逐个选出剩余的最高分吃子, 截断时无需对整个列表排序.
+      while (current_ < captures_.size()) {
+        size_t best = current_;
+        for (size_t i = current_ + 1; i < captures_.size(); ++i) {
+          if (captures_[i].score > captures_[best].score) best = i;
+        }
+        std::swap(captures_[current_], captures_[best]);
+        const Move& move = captures_[current_++].move;
+        if (!is_hash_move(move)) {
+          return move;
+        }
+      }
+      stage_ = Stage::KILLERS;
+      [[fallthrough]];
+
+    case Stage::KILLERS:
+      while (killer_index_ < killers_.size()) {
+        const Move& killer = killers_[killer_index_++];
+        if (killer_index_ == 2 && same_move(killer, killers_[0])) continue;
+        if (!is_hash_move(killer) && game_.is_pseudo_legal(state_, killer) &&
+            is_quiet(killer)) {
+          return killer;
+        }
+      }
+      stage_ = Stage::GENERATE_QUIETS;
+      [[fallthrough]];
+
+    case Stage::GENERATE_QUIETS:
+      game_.generate_moves(state_, MoveGenType::QUIETS, quiets_);
+      current_ = 0;
+      stage_ = Stage::QUIETS;
+      [[fallthrough]];
+
+    case Stage::QUIETS:
+      while (current_ < quiets_.size()) {
+        const Move& move = quiets_[current_++];
+        if (!is_hash_move(move) && !is_killer(move)) {
+          return move;
+        }
+      }
+      stage_ = Stage::DONE;
+      [[fallthrough]];
+
+    case Stage::DONE:
+      return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+bool MovePicker::is_hash_move(const Move& move) const {
+  return hash_move_ && same_move(move, *hash_move_);
+}
+
+bool MovePicker::is_killer(const Move& move) const {
+  for (const auto& killer : killers_) {
+    if (same_move(move, killer)) return true;
+  }
+  return false;
+}
+
+bool MovePicker::is_quiet(const Move& move) const {
+  if (move.promotion_piece != PieceType::EMPTY ||
+      !is_empty_square(state_.get_piece(move.to))) {
+    return false;
+  }
+  bool is_pawn = char_to_piece_type(state_.get_piece(move.from)) ==
+                 PieceType::PAWN;
+  return !(is_pawn && move.from.col != move.to.col);
+}
+
+int MovePicker::capture_score(const Move& move) const {
+  char victim = state_.get_piece(move.to);
+  int victim_value = is_empty_square(victim)
+                         ? (move.promotion_piece == PieceType::EMPTY ? 100 : 0)
+                         : piece_value(char_to_piece_type(victim));
+  int attacker_value =
+      piece_value(char_to_piece_type(state_.get_piece(move.from)));
+  return victim_value * 16 - attacker_value / 100 +
+         piece_value(move.promotion_piece) * 16;
+}
@@ -0,0 +1,232 @@
+#include "pgn.h"
+#include <cctype>
+
+bool PgnReader::read_game_text(std::string& text) {
+  text.clear();
+  bool has_movetext = false;
+  std::string line;
+
+  while (true) {
+    if (has_pending_line_) {
+      line = pending_line_;
+      has_pending_line_ = false;
+    } else if (!std::getline(in_, line)) {
+      break;
+    }
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    size_t first = line.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+      continue;
+    }
+
+    if (line[first] == '[') {
+      if (has_movetext) {
+        pending_line_ = line;
+        has_pending_line_ = true;
+        return true;
+      }
+    } else {
+      has_movetext = true;
+    }
+    text += line;
+    text += '\n';
+  }
+  return !text.empty();
+}
+
+namespace {
+
+bool is_result_token(const std::string& token) {
+  return token == "1-0" || token == "0-1" || token == "1/2-1/2" ||
+         token == "*";
+}
+
+bool is_en_passant_marker(const std::string& token) {
+  return token == "e.p." || token == "ep";
+}
+
+void parse_tag_line(const std::string& line, PgnGame& game) {
+  size_t name_begin = line.find('[') + 1;
+  size_t name_end = line.find(' ', name_begin);
+  size_t value_begin = line.find('"', name_end);
+  size_t value_end = line.rfind('"');
+  if (name_end == std::string::npos || value_begin == std::string::npos ||
+      value_end <= value_begin) {
+    return;
+  }
+  game.tags[line.substr(name_begin, name_end - name_begin)] =
+      line.substr(value_begin + 1, value_end - value_begin - 1);
+}
+
+void add_movetext_token(std::string token, PgnGame& game) {
+  // 去掉前缀的回合编号, 例如 "12." 或 "12...e5".
+  size_t i = 0;
+  while (i < token.size() && std::isdigit(static_cast<unsigned char>(token[i]))) {
+    ++i;
+  }
+  if (i < token.size() && token[i] == '.') {
+    while (i < token.size() && token[i] == '.') ++i;
+    token = token.substr(i);
+  }
+
+  while (!token.empty() &&
+         (token.back() == '+' || token.back() == '#' || token.back() == '!' ||
+          token.back() == '?')) {
+    token.pop_back();
+  }
+
+  // 吃过路兵的注记可能单独成词, 也可能直接跟在走法后面 (exf6e.p.).
+  if (token.size() > 4 && token.compare(token.size() - 4, 4, "e.p.") == 0) {
+    token.erase(token.size() - 4);
+  }
+
+  if (token.empty() || token[0] == '$' || is_result_token(token) ||
+      is_en_passant_marker(token)) {
+    return;
+  }
+  game.san_moves.push_back(token);
+}
+
+}  // namespace
+
+PgnGame parse_pgn_game(const std::string& text) {
+  PgnGame game;
+  std::string token;
+  int comment_depth = 0;
+  int variation_depth = 0;
+  bool line_comment = false;
+  bool line_start = true;
+
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+
+    if (line_comment) {
+      if (c == '\n') {
+        line_comment = false;
+        line_start = true;
+      }
+      continue;
+    }
+    if (comment_depth > 0) {
+      if (c == '}') --comment_depth;
+      continue;
+    }
+
+    if (line_start && c == '[' && variation_depth == 0) {
+      size_t end = text.find('\n', i);
+      if (end == std::string::npos) end = text.size();
+      parse_tag_line(text.substr(i, end - i), game);
+      i = end;
+      continue;
+    }
+    line_start = (c == '\n');
+
+    bool separator = std::isspace(static_cast<unsigned char>(c)) ||
+                     c == '{' || c == '}' || c == '(' || c == ')' || c == ';';
+    if (!separator) {
+      token += c;
+      continue;
+    }
+
+    if (!token.empty()) {
+      if (variation_depth == 0) add_movetext_token(token, game);
+      token.clear();
+    }
+    if (c == '{') {
+      ++comment_depth;
+    } else if (c == ';') {
+      line_comment = true;
+    } else if (c == '(') {
+      ++variation_depth;
+    } else if (c == ')' && variation_depth > 0) {
+      --variation_depth;
+    }
+  }
+  if (!token.empty() && variation_depth == 0) {
+    add_movetext_token(token, game);
+  }
+  return game;
+}
+
+std::optional<Move> san_to_move(const std::string& san,
+                                const GameState& state,
+                                const std::vector<Move>& legal_moves) {
+  if (san.empty()) {
+    return std::nullopt;
+  }
+
+  if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+    int target_col = (san.size() == 3) ? 6 : 2;
+    for (const auto& move : legal_moves) {
+      if (char_to_piece_type(state.get_piece(move.from)) == PieceType::KING &&
+          move.from.col == 4 && move.to.col == target_col) {
+        return move;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::string body = san;
+  PieceType piece_type = PieceType::PAWN;
+  if (std::isupper(static_cast<unsigned char>(body[0]))) {
+    piece_type = char_to_piece_type(body[0]);
+    if (piece_type == PieceType::EMPTY || piece_type == PieceType::PAWN) {
+      return std::nullopt;
+    }
+    body = body.substr(1);
+  }
+
+  PieceType promotion = PieceType::EMPTY;
+  size_t equals = body.find('=');
+  if (equals != std::string::npos) {
+    if (equals + 1 >= body.size()) return std::nullopt;
+    promotion = char_to_piece_type(body[equals + 1]);
+    body = body.substr(0, equals);
+  } else if (piece_type == PieceType::PAWN && !body.empty() &&
+             std::isupper(static_cast<unsigned char>(body.back()))) {
+    promotion = char_to_piece_type(body.back());
+    body.pop_back();
+  }
+
+  std::string squares;
+  for (char c : body) {
+    if (c != 'x' && c != ':' && c != '-') squares += c;
+  }
+  if (squares.size() < 2) {
+    return std::nullopt;
+  }
+
+  Position to = {'8' - squares[squares.size() - 1],
+                 squares[squares.size() - 2] - 'a'};
+  if (!to.is_valid()) {
+    return std::nullopt;
+  }
+  std::string disambiguation = squares.substr(0, squares.size() - 2);
+
+  std::optional<Move> found;
+  for (const auto& move : legal_moves) {
+    if (!(move.to == to)) continue;
+    if (char_to_piece_type(state.get_piece(move.from)) != piece_type) continue;
+    if (move.promotion_piece != promotion &&
+        !(promotion == PieceType::EMPTY &&
+          move.promotion_piece == PieceType::QUEEN)) {
+      continue;
+    }
+
+    bool matches = true;
+    for (char c : disambiguation) {
+      if (c >= 'a' && c <= 'h' && move.from.col != c - 'a') matches = false;
+      if (c >= '1' && c <= '8' && move.from.row != '8' - c) matches = false;
+    }
+    if (!matches) continue;
+
+    if (found) {
+      return std::nullopt;
+    }
+    found = move;
+  }
+  return found;
+}
@@ -0,0 +1,108 @@
+#include "zobrist.h"
+#include <array>
+#include <cctype>
+
+namespace {
+
+struct ZobristTable {
+  std::array<std::array<uint64_t, 64>, 12> pieces;
+  std::array<uint64_t, 4> castling;
+  std::array<uint64_t, 8> en_passant;
+  uint64_t side;
+
+  ZobristTable() {
+    uint64_t seed = 0x43686573735A6F62ULL;
+    auto next = [&seed]() {
+      uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    };
+    for (auto& squares : pieces) {
+      for (auto& key : squares) key = next();
+    }
+    for (auto& key : castling) key = next();
+    for (auto& key : en_passant) key = next();
+    side = next();
+  }
+};
+
+const ZobristTable& table() {
+  static const ZobristTable instance;
+  return instance;
+}
+
+int piece_index(char piece) {
+  int type = static_cast<int>(char_to_piece_type(piece));
+  return std::isupper(static_cast<unsigned char>(piece)) ? type : type + 6;
+}
+
+}  // namespace
+
+uint64_t zobrist_piece_key(char piece, const Position& pos) {
+  // 空格或非法字符不参与哈希, 避免越界读取键表.
+  if (char_to_piece_type(piece) == PieceType::EMPTY || !pos.is_valid()) {
+    return 0;
+  }
+  return table().pieces[piece_index(piece)][pos.row * 8 + pos.col];
+}
+
+uint64_t zobrist_castling_key(int castling_bit) {
+  return table().castling[castling_bit];
+}
+
+uint64_t zobrist_en_passant_key(int col) {
+  return table().en_passant[col];
+}
+
+uint64_t zobrist_side_key() {
+  return table().side;
+}
+
+uint64_t compute_position_key(const GameState& state) {
+  uint64_t key = 0;
+  for (int r = 0; r < 8; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      char piece = state.board_[r][c];
+      if (!is_empty_square(piece)) {
+        key ^= zobrist_piece_key(piece, {r, c});
+      }
+    }
+  }
+
+  const auto& rights = state.castling_rights_;
+  if (rights.white_king_side_) key ^= zobrist_castling_key(0);
+  if (rights.white_queen_side_) key ^= zobrist_castling_key(1);
+  if (rights.black_king_side_) key ^= zobrist_castling_key(2);
+  if (rights.black_queen_side_) key ^= zobrist_castling_key(3);
+
+  // 只有当吃过路兵真的可行时才计入, 否则同一局面会因走法顺序得到不同的键.
+  if (state.en_passant_target_) {
+    Position target = *state.en_passant_target_;
+    bool white_to_move = state.active_color_ == Color::WHITE;
+    int pawn_row = white_to_move ? target.row + 1 : target.row - 1;
+    char own_pawn = white_to_move ? 'P' : 'p';
+    if (state.get_piece({pawn_row, target.col - 1}) == own_pawn ||
+        state.get_piece({pawn_row, target.col + 1}) == own_pawn) {
+      key ^= zobrist_en_passant_key(target.col);
+    }
+  }
+
+  if (state.active_color_ == Color::BLACK) {
+    key ^= zobrist_side_key();
+  }
+  return key;
+}
+
+uint64_t compute_pawn_key(const GameState& state) {
+  uint64_t key = 0;
+  for (int r = 0; r < 8; ++r) {
+    for (int c = 0; c < 8; ++c) {
+      char piece = state.board_[r][c];
+      if (char_to_piece_type(piece) == PieceType::PAWN) {
+        key ^= zobrist_piece_key(piece, {r, c});
+      }
+    }
+  }
+  return key;
+}
@@ -0,0 +1,152 @@
+#include "evaluation.h"
+#include "fen.h"
+#include "game.h"
+#include "move_picker.h"
+#include "zobrist.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BenchPosition {
+  const char* name;
+  const char* fen;
+  int depth;
+  uint64_t expected_nodes;
+};
+
+const std::vector<BenchPosition> kPositions = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+     4, 197281},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     3, 97862},
+    {"endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+    {"promotion",
+     "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+};
+
+uint64_t perft(const Game& game, int depth) {
+  if (depth == 0) {
+    return 1;
+  }
+  std::vector<Move> moves = game.get_all_legal_moves();
+  if (depth == 1) {
+    return moves.size();
+  }
+  uint64_t nodes = 0;
+  for (const auto& move : moves) {
+    Game child = game;
+    child.make_move(move);
+    nodes += perft(child, depth - 1);
+  }
+  return nodes;
+}
+
+uint64_t perft_picker(const Game& game, int depth) {
+  if (depth == 0) {
+    return 1;
+  }
+  GameState state = game.get_state();
+  MovePicker picker(game, state, std::nullopt, {});
+  uint64_t nodes = 0;
+  while (std::optional<Move> move = picker.next()) {
+    if (!game.is_move_legal(state, *move)) {
+      continue;
+    }
+    Game child(state);
+    child.make_move(*move);
+    nodes += perft_picker(child, depth - 1);
+  }
+  return nodes;
+}
+
+// 在遍历的每个节点上评估局面, 同时核对增量维护的兵键.
+uint64_t perft_eval(const Game& game, int depth, Evaluator& evaluator,
+                    uint64_t& key_mismatches) {
+  GameState state = game.get_state();
+  evaluator.evaluate(state);
+  if (state.pawn_key_ != compute_pawn_key(state)) {
+    ++key_mismatches;
+  }
+  if (depth == 0) {
+    return 1;
+  }
+  uint64_t nodes = 0;
+  for (const auto& move : game.get_all_legal_moves()) {
+    Game child = game;
+    child.make_move(move);
+    nodes += perft_eval(child, depth - 1, evaluator, key_mismatches);
+  }
+  return nodes;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int extra_depth = 0;
+  bool use_picker = false;
+  bool use_eval = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--picker") {
+      use_picker = true;
+    } else if (arg == "--eval") {
+      use_eval = true;
+    } else {
+      extra_depth = std::stoi(arg);
+    }
+  }
+
+  uint64_t total_nodes = 0;
+  double total_seconds = 0;
+  bool all_correct = true;
+  Evaluator evaluator;
+  uint64_t key_mismatches = 0;
+
+  for (const auto& position : kPositions) {
+    Game game(*parse_fen(position.fen));
+    int depth = position.depth + extra_depth;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t nodes = 0;
+    if (use_eval) {
+      nodes = perft_eval(game, depth, evaluator, key_mismatches);
+    } else if (use_picker) {
+      nodes = perft_picker(game, depth);
+    } else {
+      nodes = perft(game, depth);
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    bool correct = extra_depth != 0 || nodes == position.expected_nodes;
+    all_correct = all_correct && correct;
+    total_nodes += nodes;
+    total_seconds += seconds;
+
+    std::cout << position.name << "  depth " << depth << "  nodes " << nodes
+              << "  " << seconds << " s  "
+              << static_cast<uint64_t>(nodes / seconds) << " nps"
+              << (correct ? "" : "  !! 节点数错误") << std::endl;
+  }
+
+  std::cout << "total  nodes " << total_nodes << "  " << total_seconds
+            << " s  " << static_cast<uint64_t>(total_nodes / total_seconds)
+            << " nps" << std::endl;
+
+  if (use_eval) {
+    const PawnHashTable& pawns = evaluator.pawn_table();
+    std::cout << "pawn hash  probes " << pawns.probes() << "  hits "
+              << pawns.hits() << "  hit rate " << pawns.hit_rate() * 100
+              << "%" << std::endl;
+    if (key_mismatches > 0) {
+      std::cout << "!! 兵键不一致: " << key_mismatches << std::endl;
+      all_correct = false;
+    }
+  }
+  return all_correct ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+#include "fen.h"
+#include "game.h"
+#include "game_database.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void print_usage() {
+  std::cout << "用法:\n"
+            << "  chess_db build <数据库目录> <文件.pgn>... [-j 线程数]\n"
+            << "  chess_db query <数据库目录> fen <FEN> [-n 对局数]\n"
+            << "  chess_db query <数据库目录> moves [e2e4 e7e5 ...] [-n 对局数]\n";
+}
+
+// 从 game_start 回放到 ply, 确认该局面的键与查询一致 (排除哈希碰撞),
+// 并打印对局编号, 步数和到达该局面的走法.
+bool print_game_hit(const GameDatabase& db, const Game& rules,
+                    const PositionHit& hit, uint64_t key,
+                    uint64_t standard_start_key) {
+  std::optional<GameState> state = db.game_start(hit.game_id);
+  if (!state) {
+    return false;
+  }
+  bool standard_start = compute_position_key(*state) == standard_start_key;
+  std::vector<Move> moves = db.game_moves(hit.game_id);
+  if (hit.ply > moves.size()) {
+    return false;
+  }
+  std::string line;
+  for (uint32_t i = 0; i < hit.ply; ++i) {
+    rules.apply_move(*state, moves[i]);
+    line += " " + move_to_string(moves[i]);
+  }
+  if (compute_position_key(*state) != key) {
+    return false;
+  }
+  std::cout << "  对局 #" << hit.game_id << "  第 " << hit.ply << " 步"
+            << "  (共 " << moves.size() << " 步"
+            << (standard_start ? "" : ", FEN 开局") << ")"
+            << (line.empty() ? "" : " ") << line << std::endl;
+  return true;
+}
+
+int run_build(int argc, char* argv[]) {
+  std::string directory = argv[2];
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::string> files;
+  for (int i = 3; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::max(1, std::stoi(argv[++i])));
+    } else {
+      files.push_back(arg);
+    }
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  GameDatabaseBuilder builder(threads);
+  for (const auto& file : files) {
+    if (!builder.add_pgn_file(file)) {
+      std::cout << "!! 错误: 无法读取 " << file << std::endl;
+      return 1;
+    }
+  }
+  if (!builder.write(directory)) {
+    std::cout << "!! 错误: 无法写入数据库 " << directory << std::endl;
+    return 1;
+  }
+  auto elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "对局: " << builder.game_count()
+            << "  局面: " << builder.position_count()
+            << "  无法回放: " << builder.rejected_count()
+            << "  线程: " << threads
+            << "  用时: " << elapsed << " s" << std::endl;
+  return 0;
+}
+
+int run_query(int argc, char* argv[]) {
+  GameDatabase db;
+  if (!db.open(argv[2])) {
+    std::cout << "!! 错误: 无法打开数据库 " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::string mode = argv[3];
+  size_t game_limit = 10;
+  std::vector<std::string> args;
+  for (int i = 4; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      game_limit = static_cast<size_t>(std::max(0, std::stoi(argv[++i])));
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  GameState state;
+  if (mode == "fen") {
+    std::string fen;
+    for (const auto& arg : args) {
+      fen += arg + " ";
+    }
+    std::optional<GameState> parsed = parse_fen(fen);
+    if (!parsed) {
+      std::cout << "!! 错误: 无效的 FEN" << std::endl;
+      return 1;
+    }
+    state = *parsed;
+  } else if (mode == "moves") {
+    Game game;
+    for (const auto& input : args) {
+      std::vector<Move> legal_moves = game.get_all_legal_moves();
+      auto it = std::find_if(legal_moves.begin(), legal_moves.end(),
+                             [&](const Move& m) {
+                               std::string s = move_to_string(m);
+                               return s == input || s == input + "q";
+                             });
+      if (it == legal_moves.end()) {
+        std::cout << "!! 错误: 非法走法 " << input << std::endl;
+        return 1;
+      }
+      game.make_move(*it);
+    }
+    state = game.get_state();
+  } else {
+    print_usage();
+    return 1;
+  }
+
+  uint64_t key = compute_position_key(state);
+  auto start = std::chrono::steady_clock::now();
+  PositionHits hits = db.find(key);
+  auto lookup_us = std::chrono::duration<double, std::micro>(
+      std::chrono::steady_clock::now() - start).count();
+
+  std::map<std::string, size_t> next_moves;
+  size_t final_positions = 0;
+  uint32_t last_game = UINT32_MAX;
+  size_t games = 0;
+  std::vector<PositionHit> listed;
+  for (const auto& hit : hits) {
+    if (hit.game_id != last_game) {
+      ++games;
+      last_game = hit.game_id;
+      if (listed.size() < game_limit) {
+        listed.push_back(hit);
+      }
+    }
+    std::optional<Move> next = db.move_at(hit.game_id, hit.ply);
+    if (next) {
+      ++next_moves[move_to_string(*next)];
+    } else {
+      ++final_positions;
+    }
+  }
+
+  std::vector<std::pair<std::string, size_t>> sorted(next_moves.begin(),
+                                                     next_moves.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  std::cout << "局面出现 " << hits.size << " 次, 共 " << games
+            << " 盘对局 (查找 " << lookup_us << " us)" << std::endl;
+  for (const auto& entry : sorted) {
+    std::cout << "  " << entry.first << "  " << entry.second << std::endl;
+  }
+  if (final_positions > 0) {
+    std::cout << "  (终局) " << final_positions << std::endl;
+  }
+
+  if (!listed.empty()) {
+    std::cout << "对局 (前 " << listed.size() << " 盘):" << std::endl;
+    Game rules;
+    uint64_t standard_start_key = compute_position_key(rules.get_state());
+    for (const auto& hit : listed) {
+      if (!print_game_hit(db, rules, hit, key, standard_start_key)) {
+        std::cout << "  对局 #" << hit.game_id << "  第 " << hit.ply
+                  << " 步  (!! 回放与索引不符)" << std::endl;
+      }
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc >= 4 && std::string(argv[1]) == "build") {
+    return run_build(argc, argv);
+  }
+  if (argc >= 4 && std::string(argv[1]) == "query") {
+    return run_query(argc, argv);
+  }
+  print_usage();
+  return 1;
+}
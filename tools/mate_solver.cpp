@@ -0,0 +1,65 @@
+#include "fen.h"
+#include "mate_solver.h"
+#include <iostream>
+#include <string>
+
+namespace {
+
+void print_usage() {
+  std::cout << "用法: mate_solver [-n 节点上限] [-m 置换表MB] <N> <FEN>\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint64_t node_limit = 0;
+  size_t table_megabytes = 64;
+  int max_moves = 0;
+  std::string fen;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      node_limit = std::stoull(argv[++i]);
+    } else if (arg == "-m" && i + 1 < argc) {
+      table_megabytes = std::stoul(argv[++i]);
+    } else if (max_moves == 0) {
+      max_moves = std::stoi(arg);
+    } else {
+      fen += arg + " ";
+    }
+  }
+
+  if (max_moves <= 0 || fen.empty()) {
+    print_usage();
+    return 1;
+  }
+  std::optional<GameState> root = parse_fen(fen);
+  if (!root) {
+    std::cout << "!! 错误: 无效的 FEN" << std::endl;
+    return 1;
+  }
+
+  MateSolver solver(table_megabytes);
+  MateResult result = solver.solve(*root, max_moves, node_limit);
+
+  if (result.found) {
+    std::cout << "找到 " << result.mate_in << " 步杀:";
+    for (const auto& move : result.line) {
+      std::cout << " " << move_to_string(move);
+    }
+    if (!result.line_complete) {
+      std::cout << (result.aborted ? "  (解线不完整: 达到节点上限)"
+                                   : "  (解线不完整)");
+    }
+    std::cout << std::endl;
+  } else if (result.aborted) {
+    std::cout << "达到节点上限, 未能证明 " << max_moves << " 步内杀"
+              << std::endl;
+  } else {
+    std::cout << max_moves << " 步内无杀" << std::endl;
+  }
+  std::cout << "节点: " << result.nodes << "  用时: " << result.seconds
+            << " s" << std::endl;
+  return result.found ? 0 : 2;
+}